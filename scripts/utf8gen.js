@@ -8,6 +8,68 @@ const https = require("node:https")
 
 // const PAGE_SIZE = 128
 const PAGE_SIZE = 256
+// The tables in sfce.c were generated from this version, changing it changes every table
+const UNICODE_VERSION = "14.0.0"
+const UNICODE_URL = `https://www.unicode.org/Public/${UNICODE_VERSION}/`
+
+// Layout of the one byte hot properties, must match SFCE_UTF8_HOT_PROPERTY_* in sfce.c
+const HOT_PROPERTY_WIDTH_SHIFT = 5
+const HOT_PROPERTY_PRINTABLE = 0x80
+
+// Order must match enum sfce_grapheme_break_class in sfce.c, codepoints without
+// a grapheme cluster break property are treated as "OTHER".
+const graphemeBreakClasses = [
+    "OTHER", "CR", "LF", "CONTROL", "EXTEND", "ZWJ", "REGIONAL_INDICATOR", "PREPEND",
+    "SPACINGMARK", "L", "V", "T", "LV", "LVT", "EXTENDED_PICTOGRAPHIC",
+]
+
+// Must match SFCE_GRAPHEME_BREAK in sfce.c
+const GRAPHEME_BREAK = 0x80
+
+// Order must match enum sfce_word_break_class in sfce.c, codepoints without a
+// word break property are treated as "OTHER".
+const wordBreakClasses = [
+    "OTHER", "CR", "LF", "NEWLINE", "EXTEND", "ZWJ", "REGIONAL_INDICATOR", "FORMAT",
+    "KATAKANA", "HEBREW_LETTER", "ALETTER", "SINGLE_QUOTE", "DOUBLE_QUOTE", "MIDNUMLET",
+    "MIDLETTER", "MIDNUM", "NUMERIC", "EXTENDNUMLET", "WSEGSPACE",
+]
+
+// Must match SFCE_WORD_BREAK_PICTOGRAPHIC in sfce.c, WB3c needs the extended
+// pictographic property which is orthogonal to the word break classes.
+const WORD_BREAK_PICTOGRAPHIC = 0x80
+
+// Longest sequence a codepoint fully case folds into, must match SFCE_FULL_CASE_FOLDING_MAX_LENGTH in sfce.c
+const FULL_CASE_FOLDING_MAX_LENGTH = 3
+
+// Layout of the normalization flags, must match SFCE_NORMALIZATION_* in sfce.c
+const NORMALIZATION_NFD_NO = 0x01
+const NORMALIZATION_NFC_NO = 0x02
+const NORMALIZATION_NFC_MAYBE = 0x04
+const NORMALIZATION_NON_STARTER = 0x08
+
+// Longest full canonical decomposition outside of the algorithmically decomposed hangul
+// syllables, must match SFCE_CANONICAL_DECOMPOSITION_MAX_LENGTH in sfce.c
+const CANONICAL_DECOMPOSITION_MAX_LENGTH = 4
+
+// https://www.unicode.org/versions/Unicode14.0.0/ch03.pdf#G24646
+const HANGUL_S_BASE = 0xAC00, HANGUL_S_COUNT = 11172
+const HANGUL_V_BASE = 0x1161, HANGUL_V_COUNT = 21
+const HANGUL_T_BASE = 0x11A7, HANGUL_T_COUNT = 28
+
+const printableCategories = new Set([
+    "LL", "LM", "LO", "LT", "LU",
+    "ND", "NL", "NO",
+    "MC", "ME", "MN",
+    "PC", "PD", "PE", "PF", "PI", "PO", "PS",
+    "SC", "SK", "SM", "SO",
+    "ZS",
+])
+
+const categoryValues = new Map([
+    "CN", "CC", "CF", "CO", "CS", "LL", "LM", "LO", "LT", "LU",
+    "MC", "ME", "MN", "ND", "NL", "NO", "PC", "PD", "PE", "PF",
+    "PI", "PO", "PS", "SC", "SK", "SM", "SO", "ZL", "ZP", "ZS",
+].map((category, idx) => [ category, idx ]))
 
 const unicodeLineRegex = /([0-9A-F]+);([^;]+);([A-Z]+);([0-9]+);([A-Z]+);(<([A-Z]*)>)?((\ ?[0-9A-F]+)*);([0-9]*);([0-9]*);([^;]*);([YN]*);([^;]*);([^;]*);([0-9A-F]*);([0-9A-F]*);([0-9A-F]*)$/i
 const lineHexRangeRegex = /^([0-9A-F]+)(\.\.([0-9A-F]+))?\s*;\s*([^#]*)\s*([^\r\n]*)/i
@@ -73,6 +135,16 @@ function getContentsFromURL(url) {
     })
 }
 
+// Reads `ucd/...` paths from a local copy of the unicode character database
+// when one is given, otherwise they are downloaded from UNICODE_URL.
+function getUnicodeContents(directory, name) {
+    if (directory) {
+        return fs.promises.readFile(path.join(directory, name), "utf8")
+    }
+
+    return getContentsFromURL(UNICODE_URL + name)
+}
+
 function readUnicodeDataLine(line, uppercase, lowercase) {
     const matches = line.match(unicodeLineRegex)
 
@@ -138,8 +210,8 @@ function readHexRanges(content) {
 
 function readGraphemeBoundClasses(graphemeBreakContents, emojiDataContent) {
     const graphemeBoundClass = new Map()
-    const hexRanges = [ ... readHexRanges(graphemeBreakContents),
-                        ... readHexRanges(emojiDataContent) ]
+    const emojiRanges = readHexRanges(emojiDataContent).filter(e => e.description == "Extended_Pictographic")
+    const hexRanges = [ ... readHexRanges(graphemeBreakContents), ... emojiRanges ]
     for (const {range0, range1, description} of hexRanges) {
         const newDescription = description.toUpperCase()
         for (let idx = range0; idx <= range1; ++idx) {
@@ -150,6 +222,18 @@ function readGraphemeBoundClasses(graphemeBreakContents, emojiDataContent) {
     return graphemeBoundClass
 }
 
+function readWordBreakClasses(wordBreakContents) {
+    const wordBreakClass = new Map()
+    for (const {range0, range1, description} of readHexRanges(wordBreakContents)) {
+        const newDescription = description.toUpperCase().replace(/_/g, "")
+        for (let idx = range0; idx <= range1; ++idx) {
+            wordBreakClass.set(idx, newDescription)
+        }
+    }
+
+    return wordBreakClass
+}
+
 function readEastAsianWidths(eastAsianWidthContents) {
     const eastAsianWidths = new Map()
     for (const {range0, range1, description: characterClass } of readHexRanges(eastAsianWidthContents)) {
@@ -178,17 +262,19 @@ function readUnicodeData(unicodeDataContents, uppercase, lowercase) {
     return unicodeData
 }
 
-function readCaseFolding(contents) {
+// Reads the entries of CaseFolding.txt with one of the given statuses, "CS" for
+// the simple case folding and "CF" for the full case folding.
+function readCaseFolding(contents, statuses) {
     const caseFolding = new Map()
     for (const line of toLines(contents)) {
-        const matches = line.match(/^([0-9A-F]+); [CF]; ([0-9A-F ]+);/i)
+        const matches = line.match(/^([0-9A-F]+); ([CFST]); ([0-9A-F ]+);/i)
 
-        if (matches === null || matches === undefined) {
+        if (matches === null || matches === undefined || !statuses.includes(matches[2])) {
             continue
         }
 
         const code = parseInt(matches[1], 16)
-        const sequence = matches[2].split(/\s+/).map(e => parseInt(e, 16))
+        const sequence = matches[3].trim().split(/\s+/).map(e => parseInt(e, 16))
 
         caseFolding.set(code, sequence)
     }
@@ -208,6 +294,64 @@ function readCompositionExclusions(contents) {
     return exclusions
 }
 
+function getCanonicalDecomposition(unicodeData, codepoint) {
+    const data = unicodeData.get(codepoint)
+
+    if (!data?.decompositionMapping || data.decompositionType) {
+        return [ codepoint ]
+    }
+
+    return data.decompositionMapping.flatMap(e => getCanonicalDecomposition(unicodeData, e))
+}
+
+//
+// The quick check properties follow from the decompositions, see
+// https://www.unicode.org/reports/tr15/#Primary_Exclusion_List_Table. A codepoint is
+// fully excluded from composition when it is listed in CompositionExclusions.txt, is a
+// singleton or decomposes to a non-starter. The second codepoints of the primary
+// composites can change under composition and are only "maybe" normalized.
+//
+function createNormalizationData(unicodeData, exclusions) {
+    const combiningClassOf = codepoint => unicodeData.get(codepoint)?.canonicalCombiningClass ?? 0
+    const flags = new Uint8Array(0x110000)
+    const decompositions = new Map()
+    const compositions = []
+
+    for (const [ codepoint, data ] of unicodeData) {
+        const isHangulSyllable = codepoint >= HANGUL_S_BASE && codepoint < HANGUL_S_BASE + HANGUL_S_COUNT
+        if (!data.decompositionMapping || data.decompositionType || isHangulSyllable) {
+            continue
+        }
+
+        const mapping = data.decompositionMapping
+        const fullyExcluded = exclusions.has(codepoint) || mapping.length == 1
+            || combiningClassOf(codepoint) != 0 || combiningClassOf(mapping[0]) != 0
+
+        decompositions.set(codepoint, getCanonicalDecomposition(unicodeData, codepoint))
+        flags[codepoint] |= NORMALIZATION_NFD_NO | (fullyExcluded ? NORMALIZATION_NFC_NO : 0)
+
+        if (!fullyExcluded) {
+            compositions.push([ mapping[0], mapping[1], codepoint ])
+            flags[mapping[1]] |= NORMALIZATION_NFC_MAYBE
+        }
+    }
+
+    for (let codepoint = 0; codepoint < 0x110000; ++codepoint) {
+        const decomposition = decompositions.get(codepoint) ?? [ codepoint ]
+
+        if (combiningClassOf(codepoint) != 0 || combiningClassOf(decomposition[0]) != 0) {
+            flags[codepoint] |= NORMALIZATION_NON_STARTER
+        }
+    }
+
+    for (let idx = 0; idx < HANGUL_S_COUNT; ++idx) flags[HANGUL_S_BASE + idx] |= NORMALIZATION_NFD_NO
+    for (let idx = 0; idx < HANGUL_V_COUNT; ++idx) flags[HANGUL_V_BASE + idx] |= NORMALIZATION_NFC_MAYBE
+    for (let idx = 1; idx < HANGUL_T_COUNT; ++idx) flags[HANGUL_T_BASE + idx] |= NORMALIZATION_NFC_MAYBE
+
+    compositions.sort((a, b) => a[0] - b[0] || a[1] - b[1])
+    return [ flags, decompositions, compositions ]
+}
+
 function getCodepointByteLengthUTF8(codepoint) {
     if (codepoint < 0x00) {
         return 0;
@@ -367,6 +511,70 @@ function createPagedData(array, pageSize) {
     return [ compressedData, pages, pageIndices ]
 }
 
+// Values small enough to be stored in the pages directly skip the extra
+// indirection through an array of unique values.
+function createDirectPagedData(array, pageSize) {
+    return compressAndCreateIndexArray(segmentArray(array, pageSize))
+}
+
+function getHotProperty(category, width) {
+    const printable = printableCategories.has(category) ? HOT_PROPERTY_PRINTABLE : 0
+    return categoryValues.get(category) | (width << HOT_PROPERTY_WIDTH_SHIFT) | printable
+}
+
+// https://www.unicode.org/reports/tr29/#Grapheme_Cluster_Boundary_Rules
+function isGraphemeBreak(state, previous, next) {
+    const [ OTHER, CR, LF, CONTROL, EXTEND, ZWJ, RI, PREPEND, SPACINGMARK, L, V, T, LV, LVT, EP ] = graphemeBreakClasses.keys()
+    const EP_ZWJ = graphemeBreakClasses.length + 2
+
+    if (previous == CR && next == LF) return false                                          // GB3
+    if (previous == CR || previous == LF || previous == CONTROL) return true                // GB4
+    if (next == CR || next == LF || next == CONTROL) return true                            // GB5
+    if (previous == L && (next == L || next == V || next == LV || next == LVT)) return false // GB6
+    if ((previous == LV || previous == V) && (next == V || next == T)) return false         // GB7
+    if ((previous == LVT || previous == T) && next == T) return false                       // GB8
+    if (next == EXTEND || next == ZWJ) return false                                         // GB9
+    if (next == SPACINGMARK) return false                                                   // GB9a
+    if (previous == PREPEND) return false                                                   // GB9b
+    if (state == EP_ZWJ && next == EP) return false                                         // GB11
+    if (state == RI && next == RI) return false                                             // GB12, GB13
+
+    return true                                                                             // GB999
+}
+
+//
+// The states are the class of the previous codepoint, plus three more which remember
+// the context GB11 to GB13 need: a regional indicator that completed a pair and an
+// extended pictographic followed by extends or by extends and a zero width joiner.
+// Each entry holds the next state, with GRAPHEME_BREAK set when a cluster ends
+// between the previous codepoint and the next one.
+//
+function createGraphemeBreakTransitions() {
+    const classCount = graphemeBreakClasses.length
+    const [ RI, EXTEND, ZWJ, EP ] = [ "REGIONAL_INDICATOR", "EXTEND", "ZWJ", "EXTENDED_PICTOGRAPHIC" ].map(e => graphemeBreakClasses.indexOf(e))
+    const [ RI_PAIRED, EP_EXTEND, EP_ZWJ ] = [ classCount, classCount + 1, classCount + 2 ]
+    const stateClasses = new Map([ [ RI_PAIRED, RI ], [ EP_EXTEND, EXTEND ], [ EP_ZWJ, ZWJ ] ])
+    const transitions = []
+
+    for (let state = 0; state < classCount + 3; ++state) {
+        const previous = stateClasses.get(state) ?? state
+
+        for (let next = 0; next < classCount; ++next) {
+            const isBreak = isGraphemeBreak(state, previous, next)
+            const afterPictographic = state == EP || state == EP_EXTEND
+
+            let nextState = next
+            if (next == EXTEND && afterPictographic) nextState = EP_EXTEND
+            else if (next == ZWJ && afterPictographic) nextState = EP_ZWJ
+            else if (next == RI && state == RI && !isBreak) nextState = RI_PAIRED
+
+            transitions.push(nextState | (isBreak ? GRAPHEME_BREAK : 0))
+        }
+    }
+
+    return transitions
+}
+
 function getLargestElementLengthAsString(array) {
     let length = 0
 
@@ -416,15 +624,17 @@ function createProgramUnicodeDescriptors(unicodeData, eastAsianWidths) {
 
 async function main() {
     const filepath = process.argv[2] || "ignore/sfce_utf8_properties.c"
-
-    console.log("Loading files from url: 'https://www.unicode.org/Public/16.0.0/'!")
-    const UNICODE_DATA = await getContentsFromURL("https://www.unicode.org/Public/16.0.0/ucd/UnicodeData.txt")
-    // const GRAPHEME_BREAK_PROPERTY = await getContentsFromURL("https://www.unicode.org/Public/16.0.0/ucd/auxiliary/GraphemeBreakProperty.txt")
-    const DERIVED_CORE_PROPERTIES = await getContentsFromURL("https://www.unicode.org/Public/16.0.0/ucd/DerivedCoreProperties.txt")
-    // const COMPOSITION_EXCLUSIONS = await getContentsFromURL("https://www.unicode.org/Public/16.0.0/ucd/CompositionExclusions.txt")
-    // const CASE_FOLDING = await getContentsFromURL("https://www.unicode.org/Public/16.0.0/ucd/CaseFolding.txt")
-    const EAST_ASIAN_WIDTH = await getContentsFromURL("https://www.unicode.org/Public/16.0.0/ucd/EastAsianWidth.txt")
-    // const EMOJI_DATA = await getContentsFromURL("https://www.unicode.org/Public/16.0.0/ucd/emoji/emoji-data.txt")
+    const directory = process.argv[3]
+
+    console.log(`Loading files from '${directory ?? UNICODE_URL}'!`)
+    const UNICODE_DATA = await getUnicodeContents(directory, "ucd/UnicodeData.txt")
+    const GRAPHEME_BREAK_PROPERTY = await getUnicodeContents(directory, "ucd/auxiliary/GraphemeBreakProperty.txt")
+    const WORD_BREAK_PROPERTY = await getUnicodeContents(directory, "ucd/auxiliary/WordBreakProperty.txt")
+    const DERIVED_CORE_PROPERTIES = await getUnicodeContents(directory, "ucd/DerivedCoreProperties.txt")
+    const COMPOSITION_EXCLUSIONS = await getUnicodeContents(directory, "ucd/CompositionExclusions.txt")
+    const CASE_FOLDING = await getUnicodeContents(directory, "ucd/CaseFolding.txt")
+    const EAST_ASIAN_WIDTH = await getUnicodeContents(directory, "ucd/EastAsianWidth.txt")
+    const EMOJI_DATA = await getUnicodeContents(directory, "ucd/emoji/emoji-data.txt")
 
     console.log("Parsing the information from the loaded files!")
     const derivedCoreProperties = readHexRanges(DERIVED_CORE_PROPERTIES)
@@ -432,15 +642,27 @@ async function main() {
     const uppercase = createSetFromRanges(derivedCoreProperties.filter(e => e.description == "Uppercase"))
     const lowercase = createSetFromRanges(derivedCoreProperties.filter(e => e.description == "Lowercase"))
 
-    // const graphemeBoundClasses = readGraphemeBoundClasses(GRAPHEME_BREAK_PROPERTY, EMOJI_DATA)
+    const graphemeBoundClasses = readGraphemeBoundClasses(GRAPHEME_BREAK_PROPERTY, EMOJI_DATA)
+    const wordBreakClassNames = readWordBreakClasses(WORD_BREAK_PROPERTY)
     const eastAsianWidths = readEastAsianWidths(EAST_ASIAN_WIDTH)
     const unicodeData = readUnicodeData(UNICODE_DATA, uppercase, lowercase)
-    // const caseFolding = readCaseFolding(CASE_FOLDING)
-    // const exclusions = readCompositionExclusions(COMPOSITION_EXCLUSIONS)
+    const simpleCaseFolding = readCaseFolding(CASE_FOLDING, "CS")
+    const fullCaseFolding = readCaseFolding(CASE_FOLDING, "CF")
+    const exclusions = new Set(readCompositionExclusions(COMPOSITION_EXCLUSIONS))
+    const [ normalizationFlags, canonicalDecompositions, canonicalCompositions ] = createNormalizationData(unicodeData, exclusions)
 
     console.log("Grouping unicode properties!")
 
     const propertyStrings = []
+    const hotProperties = []
+    const graphemeBreakClassValues = []
+    const wordBreakClassValues = []
+    const caseDeltaStrings = []
+    const fullCaseFoldingIndices = []
+    const fullCaseFoldingStrings = []
+    const canonicalDecompositionIndices = []
+    const canonicalDecompositionStrings = []
+    const normalizedWordBreakClasses = wordBreakClasses.map(e => e.replace(/_/g, ""))
 
     for (let codepoint = 0; codepoint < 0x110000; ++codepoint) {
         const data = unicodeData.get(codepoint)
@@ -458,6 +680,42 @@ async function main() {
 
         // propertyStrings.push(`{ SFCE_UNICODE_CATEGORY_${category}, ${combiningClass}, SFCE_UNICODE_BIDI_CLASS_${bidiClass}, SFCE_UNICODE_DECOMPOSITION_${decomposition}, ${uppercaseMapping}, ${lowercaseMapping}, ${titleCaseMapping}, ${width}, ${bidiMirrored} }`)
         propertyStrings.push(`{ SFCE_UNICODE_CATEGORY_${category}, SFCE_UNICODE_BIDI_CLASS_${bidiClass}, SFCE_UNICODE_DECOMPOSITION_${decomposition}, ${bidiMirrored}, ${width}, ${combiningClass}, ${uppercaseMapping}, ${lowercaseMapping}, ${titleCaseMapping} }`)
+        hotProperties.push(getHotProperty(category, width))
+        graphemeBreakClassValues.push(Math.max(0, graphemeBreakClasses.indexOf(graphemeBoundClasses.get(codepoint))))
+
+        const wordBreakClass = Math.max(0, normalizedWordBreakClasses.indexOf(wordBreakClassNames.get(codepoint)))
+        const pictographic = graphemeBoundClasses.get(codepoint) == "EXTENDED_PICTOGRAPHIC" ? WORD_BREAK_PICTOGRAPHIC : 0
+        wordBreakClassValues.push(wordBreakClass | pictographic)
+
+        // Mappings are stored as the distance to the mapped codepoint so that codepoints
+        // without one share the zero delta and the lookup never has to test for -1.
+        const uppercaseDelta = uppercaseMapping == -1 ? 0 : uppercaseMapping - codepoint
+        const lowercaseDelta = lowercaseMapping == -1 ? 0 : lowercaseMapping - codepoint
+        const titleCaseDelta = titleCaseMapping == -1 ? 0 : titleCaseMapping - codepoint
+        const caseFoldingDelta = (simpleCaseFolding.get(codepoint)?.[0] ?? codepoint) - codepoint
+        caseDeltaStrings.push(`{ ${uppercaseDelta}, ${lowercaseDelta}, ${titleCaseDelta}, ${caseFoldingDelta} }`)
+
+        // Only the foldings into more than one codepoint need a table of their own, the
+        // others are the same as the simple case folding. Index zero means there is none.
+        const fullFolding = fullCaseFolding.get(codepoint)
+        if (fullFolding !== undefined && fullFolding.length > 1) {
+            const padding = Array(FULL_CASE_FOLDING_MAX_LENGTH - fullFolding.length).fill(0)
+            fullCaseFoldingStrings.push(`{ ${[ ...fullFolding, ...padding ].join(", ")} }`)
+            fullCaseFoldingIndices.push(fullCaseFoldingStrings.length)
+        }
+        else {
+            fullCaseFoldingIndices.push(0)
+        }
+
+        const canonicalDecomposition = canonicalDecompositions.get(codepoint)
+        if (canonicalDecomposition !== undefined) {
+            const padding = Array(CANONICAL_DECOMPOSITION_MAX_LENGTH - canonicalDecomposition.length).fill(0)
+            canonicalDecompositionStrings.push(`{ ${[ ...canonicalDecomposition, ...padding ].join(", ")} }`)
+            canonicalDecompositionIndices.push(canonicalDecompositionStrings.length)
+        }
+        else {
+            canonicalDecompositionIndices.push(0)
+        }
     }
 
     console.log(`Compressing ${propertyStrings.length} unicode properties!`)
@@ -469,18 +727,59 @@ async function main() {
 
     console.log(`Created ${pages.length} pages of unicode data!`)
 
+    const [hotPages, hotPageOffsets] = createDirectPagedData(hotProperties, PAGE_SIZE)
+    console.log(`Created ${hotPages.length} pages of hot unicode properties!`)
+
+    const [graphemePages, graphemePageOffsets] = createDirectPagedData(graphemeBreakClassValues, PAGE_SIZE)
+    const graphemeBreakTransitions = createGraphemeBreakTransitions()
+    console.log(`Created ${graphemePages.length} pages of grapheme break classes!`)
+
+    const [wordBreakPages, wordBreakPageOffsets] = createDirectPagedData(wordBreakClassValues, PAGE_SIZE)
+    console.log(`Created ${wordBreakPages.length} pages of word break classes!`)
+
+    const [caseDeltas, caseDeltaPages, caseDeltaPageOffsets] = createPagedData(caseDeltaStrings, PAGE_SIZE)
+    console.log(`Created ${caseDeltaPages.length} pages of ${caseDeltas.length} unique case mapping deltas!`)
+
+    const [fullCaseFoldingPages, fullCaseFoldingPageOffsets] = createDirectPagedData(fullCaseFoldingIndices, PAGE_SIZE)
+    console.log(`Created ${fullCaseFoldingPages.length} pages of ${fullCaseFoldingStrings.length} full case foldings!`)
+
+    const [normalizationPages, normalizationPageOffsets] = createDirectPagedData(Array.from(normalizationFlags), PAGE_SIZE)
+    console.log(`Created ${normalizationPages.length} pages of normalization flags!`)
+
+    const [canonicalDecompositionPages, canonicalDecompositionPageOffsets] = createDirectPagedData(canonicalDecompositionIndices, PAGE_SIZE)
+    console.log(`Created ${canonicalDecompositionPages.length} pages of ${canonicalDecompositionStrings.length} canonical decompositions and ${canonicalCompositions.length} compositions!`)
+
     console.log(`Writing ${compressedData.length} unicode properties to "${filepath}"!`)
 
     const stream = fs.createWriteStream(filepath)
     stream.write(`\
 //
-// Auto generated by ${path.basename(__filename)} at ${new Date().toLocaleDateString()}
+// Auto generated by ${path.basename(__filename)} at ${new Date().toISOString().slice(0, 10)}
 // Using a page size of ${PAGE_SIZE} bytes.
-// 
+//
 `)
     stream.write(`static const struct sfce_utf8_property utf8_properties[${compressedData.length}] = ${formatDataAsCArray(compressedData)};\n`)
-    stream.write(`int16_t utf8_property_indices[${indices.length}] = ${formatDataAsCArray(indices)};\n`)
-    stream.write(`int16_t utf8_property_page_offsets[${pageOffsets.length}] = ${formatDataAsCArray(pageOffsets)};\n`)
+    stream.write(`static const uint16_t utf8_property_indices[${indices.length}] = ${formatDataAsCArray(indices)};\n`)
+    stream.write(`static const uint8_t utf8_property_page_offsets[${pageOffsets.length}] = ${formatDataAsCArray(pageOffsets)};\n`)
+    stream.write(`static const uint8_t utf8_hot_properties[${hotPages.length * PAGE_SIZE}] = ${formatDataAsCArray(hotPages.flat())};\n`)
+    stream.write(`static const uint8_t utf8_hot_property_page_offsets[${hotPageOffsets.length}] = ${formatDataAsCArray(hotPageOffsets)};\n`)
+    stream.write(`static const uint8_t utf8_grapheme_break_classes[${graphemePages.length * PAGE_SIZE}] = ${formatDataAsCArray(graphemePages.flat())};\n`)
+    stream.write(`static const uint8_t utf8_grapheme_break_class_page_offsets[${graphemePageOffsets.length}] = ${formatDataAsCArray(graphemePageOffsets)};\n`)
+    stream.write(`static const uint8_t grapheme_break_transitions[${graphemeBreakTransitions.length}] = ${formatDataAsCArray(graphemeBreakTransitions)};\n`)
+    stream.write(`static const uint8_t utf8_word_break_classes[${wordBreakPages.length * PAGE_SIZE}] = ${formatDataAsCArray(wordBreakPages.flat())};\n`)
+    stream.write(`static const uint8_t utf8_word_break_class_page_offsets[${wordBreakPageOffsets.length}] = ${formatDataAsCArray(wordBreakPageOffsets)};\n`)
+    stream.write(`static const int32_t utf8_case_deltas[${caseDeltas.length}][SFCE_CASE_MAPPING_COUNT] = ${formatDataAsCArray(caseDeltas)};\n`)
+    stream.write(`static const uint8_t utf8_case_delta_indices[${caseDeltaPages.length * PAGE_SIZE}] = ${formatDataAsCArray(caseDeltaPages.flat())};\n`)
+    stream.write(`static const uint8_t utf8_case_delta_page_offsets[${caseDeltaPageOffsets.length}] = ${formatDataAsCArray(caseDeltaPageOffsets)};\n`)
+    stream.write(`static const int32_t utf8_full_case_foldings[${fullCaseFoldingStrings.length + 1}][SFCE_FULL_CASE_FOLDING_MAX_LENGTH] = ${formatDataAsCArray([ "{ 0, 0, 0 }", ...fullCaseFoldingStrings ])};\n`)
+    stream.write(`static const uint8_t utf8_full_case_folding_indices[${fullCaseFoldingPages.length * PAGE_SIZE}] = ${formatDataAsCArray(fullCaseFoldingPages.flat())};\n`)
+    stream.write(`static const uint8_t utf8_full_case_folding_page_offsets[${fullCaseFoldingPageOffsets.length}] = ${formatDataAsCArray(fullCaseFoldingPageOffsets)};\n`)
+    stream.write(`static const uint8_t utf8_normalization_flags[${normalizationPages.length * PAGE_SIZE}] = ${formatDataAsCArray(normalizationPages.flat())};\n`)
+    stream.write(`static const uint8_t utf8_normalization_flag_page_offsets[${normalizationPageOffsets.length}] = ${formatDataAsCArray(normalizationPageOffsets)};\n`)
+    stream.write(`static const int32_t utf8_canonical_decompositions[${canonicalDecompositionStrings.length + 1}][SFCE_CANONICAL_DECOMPOSITION_MAX_LENGTH] = ${formatDataAsCArray([ "{ 0, 0, 0, 0 }", ...canonicalDecompositionStrings ])};\n`)
+    stream.write(`static const uint16_t utf8_canonical_decomposition_indices[${canonicalDecompositionPages.length * PAGE_SIZE}] = ${formatDataAsCArray(canonicalDecompositionPages.flat())};\n`)
+    stream.write(`static const uint8_t utf8_canonical_decomposition_page_offsets[${canonicalDecompositionPageOffsets.length}] = ${formatDataAsCArray(canonicalDecompositionPageOffsets)};\n`)
+    stream.write(`static const int32_t utf8_canonical_compositions[${canonicalCompositions.length}][3] = ${formatDataAsCArray(canonicalCompositions.map(e => `{ ${e.join(", ")} }`))};\n`)
     stream.close()
 }
 
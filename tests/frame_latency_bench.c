@@ -0,0 +1,190 @@
+//
+// Measures how long keypresses take to reach a slow terminal. The console writes
+// into a stand-in terminal which takes us_per_byte microseconds to take in every
+// byte, while keypresses arrive every key_interval_ms milliseconds. A keypress is
+// presented once every byte of the first frame drawn after it has been taken in.
+//
+//     frame_latency_bench [us_per_byte] [key_interval_ms] [skip|all] [file]
+//
+// With skip, frames are only built while the writer thread is idle the way the
+// editor does it, with all a frame is built after every keypress. make bench-latency
+// runs it over sfce.c at a few rates.
+//
+#include <windows.h>
+
+BOOL bench_write_console(HANDLE handle, const void *buffer, DWORD buffer_size, DWORD *written_size, void *reserved);
+
+#undef WriteConsole
+#define WriteConsole bench_write_console
+
+#define main sfce_main
+#include "../sfce.c"
+#undef main
+
+enum { BENCH_KEY_COUNT = 400 };
+enum { BENCH_EDITED_ROW = 20 };
+
+static volatile int64_t g_bench_us_per_byte = 0;
+static volatile int64_t g_bench_taken_byte_count = 0;
+
+//
+// The stand-in terminal, it takes in the bytes at the throttled rate on whichever
+// thread writes them, the same way a full terminal holds up its writer.
+//
+BOOL bench_write_console(HANDLE handle, const void *buffer, DWORD buffer_size, DWORD *written_size, void *reserved)
+{
+    (void)handle;
+    (void)buffer;
+    (void)reserved;
+
+    int64_t end_time = sfce_get_time_microseconds() + (int64_t)buffer_size * g_bench_us_per_byte;
+    while (sfce_get_time_microseconds() < end_time) {
+    }
+
+    __atomic_add_fetch(&g_bench_taken_byte_count, (int64_t)buffer_size, __ATOMIC_SEQ_CST);
+    *written_size = buffer_size;
+    return TRUE;
+}
+
+struct bench_frames {
+    int64_t end_byte_counts[BENCH_KEY_COUNT];
+    int64_t key_times[BENCH_KEY_COUNT];
+    int32_t built_count;
+    int32_t presented_count;
+    int64_t latency_sum;
+    int64_t latency_max;
+};
+
+static void bench_present_frames(struct bench_frames *frames)
+{
+    int64_t taken_byte_count = __atomic_load_n(&g_bench_taken_byte_count, __ATOMIC_SEQ_CST);
+    int64_t time = sfce_get_time_microseconds();
+
+    while (frames->presented_count < frames->built_count && frames->end_byte_counts[frames->presented_count] <= taken_byte_count) {
+        int64_t latency = time - frames->key_times[frames->presented_count];
+        frames->latency_sum += latency;
+        frames->latency_max = MAX(frames->latency_max, latency);
+        frames->presented_count += 1;
+    }
+}
+
+//
+// Types ten characters and a line break, then moves the cursor down five rows and
+// back up four, so frames change a few rows and now and then scroll.
+//
+static void bench_press_key(struct sfce_editor_window *window, int32_t key_index)
+{
+    struct sfce_position *position = &window->cursors->position;
+    int32_t step = key_index % 20;
+
+    if (step < 10) {
+        sfce_piece_tree_insert_with_position(window->tree, *position, (const uint8_t *)"x", 1);
+        position->col += 1;
+    }
+    else if (step == 10) {
+        sfce_piece_tree_insert_with_position(window->tree, *position, (const uint8_t *)"\n", 1);
+        position->row += 1;
+        position->col = 0;
+    }
+    else if (step < 16) {
+        position->row = MIN(position->row + 1, window->tree->line_count - 1);
+        position->col = 0;
+    }
+    else {
+        position->row = MAX(position->row - 1, 0);
+        position->col = 0;
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    g_bench_us_per_byte = argc > 1 ? atoi(argv[1]) : 20;
+    int64_t key_interval = (argc > 2 ? atof(argv[2]) : 5.0) * 1000;
+    uint8_t should_skip_frames = argc > 3 ? strcmp(argv[3], "all") != 0 : SFCE_TRUE;
+    const char *filepath = argc > 4 ? argv[4] : "sfce.c";
+
+    struct sfce_console_buffer console = {};
+    enum sfce_error_code error_code = sfce_console_buffer_create(&console);
+    if (error_code != SFCE_ERROR_OK) {
+        fprintf(stderr, "ERROR CODE: %s\n", sfce_error_code_names[error_code]);
+        return 1;
+    }
+
+    struct sfce_piece_tree *tree = sfce_piece_tree_create();
+    error_code = sfce_piece_tree_load_file(tree, filepath);
+    if (error_code != SFCE_ERROR_OK) {
+        fprintf(stderr, "Unable to load %s\n", filepath);
+        return 1;
+    }
+
+    struct sfce_arena frame_arena = {};
+    struct sfce_editor_window window = {
+        .rectangle.right = console.window_size.width - 1,
+        .rectangle.bottom = console.window_size.height - 1,
+        .tree = tree,
+        .split_kind = SFCE_SPLIT_NONE,
+        .enable_line_numbering = 1,
+    };
+
+    window.cursors = sfce_cursor_create(&window);
+    window.cursors->position.row = MIN(BENCH_EDITED_ROW, tree->line_count - 1);
+
+    sfce_console_buffer_write_output(&console, SFCE_TRUE);
+    int64_t start_byte_count = console.total_frame_stats.written_byte_count;
+    __atomic_store_n(&g_bench_taken_byte_count, 0, __ATOMIC_SEQ_CST);
+
+    static struct bench_frames frames = {};
+    int64_t start_time = sfce_get_time_microseconds();
+    int64_t next_key_time = start_time;
+    int64_t oldest_key_time = -1;
+    int32_t key_count = 0;
+    uint8_t should_render = SFCE_FALSE;
+
+    while (key_count < BENCH_KEY_COUNT || should_render || frames.presented_count < frames.built_count) {
+        if (key_count < BENCH_KEY_COUNT && sfce_get_time_microseconds() >= next_key_time) {
+            bench_press_key(&window, key_count);
+
+            if (oldest_key_time < 0) {
+                oldest_key_time = next_key_time;
+            }
+
+            next_key_time += key_interval;
+            key_count += 1;
+            should_render = SFCE_TRUE;
+        }
+
+        sfce_console_buffer_write_output(&console, SFCE_FALSE);
+        bench_present_frames(&frames);
+
+        if (should_render && (!should_skip_frames || !sfce_console_buffer_is_writing(&console))) {
+            should_render = SFCE_FALSE;
+
+            sfce_console_buffer_update(&console);
+            sfce_editor_window_display(&window, &console, &frame_arena);
+            sfce_console_buffer_flush(&console);
+
+            frames.end_byte_counts[frames.built_count] = console.total_frame_stats.written_byte_count - start_byte_count;
+            frames.key_times[frames.built_count] = oldest_key_time;
+            frames.built_count += 1;
+            oldest_key_time = -1;
+
+            bench_present_frames(&frames);
+        }
+    }
+
+    int64_t elapsed_time = sfce_get_time_microseconds() - start_time;
+
+    sfce_arena_destroy(&frame_arena);
+    sfce_console_buffer_destroy(&console);
+    sfce_piece_tree_destroy(tree);
+
+    fprintf(
+        stderr, "%d us/byte, %d keys, %d frames built, %.1f ms avg key-to-present, %.1f ms max, total %.0f ms\n",
+        (int)g_bench_us_per_byte, key_count, frames.built_count,
+        frames.latency_sum / 1000.0 / MAX(frames.presented_count, 1),
+        frames.latency_max / 1000.0,
+        elapsed_time / 1000.0
+    );
+
+    return 0;
+}
@@ -0,0 +1,439 @@
+//
+// Regression tests for the piece tree, the editor is compiled in with its entry
+// point renamed so the tests can reach every function of sfce.c.
+//
+#define main sfce_main
+#include "../sfce.c"
+#undef main
+
+enum { TEST_PASTE_SIZE = 0x300000 };
+enum { TEST_ERASE_COUNT = 4000 };
+enum { TEST_ERASE_MAX_SIZE = 3000 };
+enum { TEST_CONVERT_CASE_SIZE = 0x1B0000 };
+enum { TEST_SNAPSHOT_SIZE = 0x40000 };
+enum { TEST_READER_THREAD_COUNT = 4 };
+enum { TEST_THREAD_STEP_COUNT = 2000 };
+enum { TEST_STRING_BUFFER_MULTIPLE = 3 };
+
+struct test_document {
+    uint8_t *data;
+    int32_t  size;
+};
+
+struct test_thread {
+    struct sfce_piece_tree *shared_tree;
+    struct test_document   *shared_document;
+    uint32_t                seed;
+    int32_t                 failed_check_count;
+#if defined(SFCE_PLATFORM_WINDOWS)
+    HANDLE                  handle;
+#else
+    pthread_t               handle;
+#endif
+};
+
+static int32_t g_failed_test_count = 0;
+
+#define TEST_EXPECT(condition) do {                                             \
+    if (!(condition)) {                                                         \
+        fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #condition); \
+        g_failed_test_count += 1;                                               \
+        return;                                                                 \
+    }                                                                           \
+} while (0)
+
+//
+// Returns the black height of the subtree, or -1 when a red node has a red child
+// or the black heights of its two sides differ.
+//
+static int32_t test_black_height(struct sfce_piece_node *node)
+{
+    if (node == sentinel_ptr) {
+        return 1;
+    }
+
+    int32_t left_height = test_black_height(node->left);
+    int32_t right_height = test_black_height(node->right);
+
+    if (left_height < 0 || left_height != right_height) {
+        return -1;
+    }
+
+    if (node->color == SFCE_COLOR_RED && (node->left->color == SFCE_COLOR_RED || node->right->color == SFCE_COLOR_RED)) {
+        return -1;
+    }
+
+    return left_height + (node->color == SFCE_COLOR_BLACK);
+}
+
+static uint8_t test_tree_matches(struct sfce_piece_tree *tree, struct test_document *document)
+{
+    struct sfce_string content = {};
+    int32_t line_count = 1 + buffer_newline_count(document->data, document->size);
+    uint8_t matches = sfce_piece_tree_get_node_content(tree, tree->root, &content) == SFCE_ERROR_OK
+        && content.size == document->size
+        && (document->size == 0 || memcmp(content.data, document->data, document->size) == 0)
+        && tree->length == document->size
+        && tree->line_count == line_count
+        && test_black_height(tree->root) > 0;
+
+    sfce_string_destroy(&content);
+    return matches;
+}
+
+static void test_document_insert(struct test_document *document, int32_t offset, const uint8_t *data, int32_t size)
+{
+    memmove(&document->data[offset + size], &document->data[offset], document->size - offset);
+    memcpy(&document->data[offset], data, size);
+    document->size += size;
+}
+
+static void test_document_erase(struct test_document *document, int32_t offset, int32_t size)
+{
+    memmove(&document->data[offset], &document->data[offset + size], document->size - offset - size);
+    document->size -= size;
+}
+
+//
+// Content larger than a string buffer is split over several pieces, which used to
+// be linked in as one unbalanced subtree that later erasures tripped over.
+//
+static void test_paste_then_erase_at_random(void)
+{
+    struct sfce_piece_tree *tree = sfce_piece_tree_create();
+    struct test_document document = { .data = malloc(2 * TEST_PASTE_SIZE) };
+    uint8_t *paste = malloc(TEST_PASTE_SIZE);
+
+    TEST_EXPECT(tree != NULL && document.data != NULL && paste != NULL);
+
+    for (int32_t idx = 0; idx < TEST_PASTE_SIZE; ++idx) {
+        paste[idx] = idx % 73 == 72 ? '\n' : 'a' + idx % 26;
+    }
+
+    for (int32_t idx = 0; idx < 2; ++idx) {
+        int32_t offset = document.size / 2;
+        TEST_EXPECT(sfce_piece_tree_insert_with_offset(tree, offset, paste, TEST_PASTE_SIZE) == SFCE_ERROR_OK);
+        test_document_insert(&document, offset, paste, TEST_PASTE_SIZE);
+        TEST_EXPECT(test_tree_matches(tree, &document));
+    }
+
+    srand(1);
+    for (int32_t idx = 0; idx < TEST_ERASE_COUNT && document.size != 0; ++idx) {
+        int32_t offset = rand() % document.size;
+        int32_t size = rand() % (1 + MIN(TEST_ERASE_MAX_SIZE, document.size - offset));
+        TEST_EXPECT(sfce_piece_tree_erase_with_offset(tree, offset, size) == SFCE_ERROR_OK);
+        test_document_erase(&document, offset, size);
+    }
+
+    TEST_EXPECT(test_tree_matches(tree, &document));
+
+    free(paste);
+    free(document.data);
+    sfce_piece_tree_destroy(tree);
+}
+
+//
+// Converting the case of a range puts it back as new pieces, a range larger than a
+// string buffer has to be inserted as several of them.
+//
+static void test_convert_case_larger_than_a_string_buffer(void)
+{
+    static const char lower[] = "abc \xC3\xA4\xC3\xB6\xC3\xBC xyz\n";
+    static const char upper[] = "ABC \xC3\x84\xC3\x96\xC3\x9C XYZ\n";
+    int32_t pattern_size = COUNTOF(lower) - 1;
+    int32_t size = TEST_CONVERT_CASE_SIZE / pattern_size * pattern_size;
+
+    struct sfce_piece_tree *tree = sfce_piece_tree_create();
+    struct test_document document = { .data = malloc(size) };
+    uint8_t *content = malloc(size);
+
+    TEST_EXPECT(tree != NULL && document.data != NULL && content != NULL);
+
+    for (int32_t idx = 0; idx < size; idx += pattern_size) {
+        memcpy(&content[idx], lower, pattern_size);
+    }
+
+    TEST_EXPECT(sfce_piece_tree_insert_with_offset(tree, 0, content, size) == SFCE_ERROR_OK);
+    test_document_insert(&document, 0, content, size);
+
+    for (int32_t idx = pattern_size; idx < size - pattern_size; idx += pattern_size) {
+        memcpy(&document.data[idx], upper, pattern_size);
+    }
+
+    TEST_EXPECT(sfce_piece_tree_convert_case(tree, pattern_size, size - 2 * pattern_size, SFCE_CASE_MAPPING_UPPER) == SFCE_ERROR_OK);
+    TEST_EXPECT(test_tree_matches(tree, &document));
+
+    srand(2);
+    for (int32_t idx = 0; idx < TEST_ERASE_COUNT; ++idx) {
+        int32_t offset = rand() % document.size;
+        int32_t erase_size = MIN(3, document.size - offset);
+        TEST_EXPECT(sfce_piece_tree_erase_with_offset(tree, offset, erase_size) == SFCE_ERROR_OK);
+        test_document_erase(&document, offset, erase_size);
+    }
+
+    TEST_EXPECT(test_tree_matches(tree, &document));
+
+    free(content);
+    free(document.data);
+    sfce_piece_tree_destroy(tree);
+}
+
+//
+// The digraphs of U+01C4 to U+01F3 have a titlecase form of their own, and the
+// Georgian letters have an uppercase but no titlecase form in Unicode 14.0.0.
+//
+static void test_convert_case_to_titlecase(void)
+{
+    static const int32_t titlecase_mappings[][2] = {
+        { 0x01C4, 0x01C5 }, { 0x01C5, 0x01C5 }, { 0x01C6, 0x01C5 },
+        { 0x01C7, 0x01C8 }, { 0x01C8, 0x01C8 }, { 0x01C9, 0x01C8 },
+        { 0x01CA, 0x01CB }, { 0x01CB, 0x01CB }, { 0x01CC, 0x01CB },
+        { 0x01F1, 0x01F2 }, { 0x01F2, 0x01F2 }, { 0x01F3, 0x01F2 },
+        { 0x10D0, 0x10D0 }, { 0x10FA, 0x10FA }, { 0x10FD, 0x10FD },
+        { 0x10FF, 0x10FF }, { 0x0061, 0x0041 },
+    };
+
+    static const char lower[] = "\xC7\x86\xC7\x89\xC7\x8C\xC7\xB3 \xE1\x83\x90";
+    static const char title[] = "\xC7\x85\xC7\x88\xC7\x8B\xC7\xB2 \xE1\x83\x90";
+
+    for (int32_t idx = 0; idx < COUNTOF(titlecase_mappings); ++idx) {
+        TEST_EXPECT(sfce_codepoint_to_title(titlecase_mappings[idx][0]) == titlecase_mappings[idx][1]);
+    }
+
+    TEST_EXPECT(sfce_codepoint_to_upper(0x01C5) == 0x01C4);
+    TEST_EXPECT(sfce_codepoint_to_upper(0x10D0) == 0x1C90);
+
+    struct sfce_piece_tree *tree = sfce_piece_tree_create();
+    struct test_document document = { .data = (uint8_t *)title, .size = COUNTOF(title) - 1 };
+
+    TEST_EXPECT(tree != NULL);
+    TEST_EXPECT(sfce_piece_tree_insert_with_offset(tree, 0, (const uint8_t *)lower, COUNTOF(lower) - 1) == SFCE_ERROR_OK);
+    TEST_EXPECT(sfce_piece_tree_convert_case(tree, 0, tree->length, SFCE_CASE_MAPPING_TITLE) == SFCE_ERROR_OK);
+    TEST_EXPECT(test_tree_matches(tree, &document));
+
+    sfce_piece_tree_destroy(tree);
+}
+
+//
+// Erasing enough text collects the string buffers that are no longer referenced,
+// which must not include the buffers the pieces of a snapshot refer to.
+//
+static void test_snapshot_survives_garbage_collection(void)
+{
+    struct sfce_piece_tree *tree = sfce_piece_tree_create();
+    struct sfce_piece_tree_snapshot snapshot = {};
+    struct sfce_piece_tree_stats stats = {};
+    struct test_document document = { .data = malloc(TEST_SNAPSHOT_SIZE) };
+
+    TEST_EXPECT(tree != NULL && document.data != NULL);
+
+    for (int32_t idx = 0; idx < TEST_SNAPSHOT_SIZE; ++idx) {
+        document.data[idx] = idx % 61 == 60 ? '\n' : 'A' + idx % 26;
+    }
+
+    document.size = TEST_SNAPSHOT_SIZE;
+    TEST_EXPECT(sfce_piece_tree_insert_with_offset(tree, 0, document.data, document.size) == SFCE_ERROR_OK);
+    TEST_EXPECT(sfce_piece_tree_create_snapshot(tree, &snapshot) == SFCE_ERROR_OK);
+
+    TEST_EXPECT(sfce_piece_tree_erase_with_offset(tree, 0, tree->length) == SFCE_ERROR_OK);
+    TEST_EXPECT(sfce_piece_tree_insert_with_offset(tree, 0, (const uint8_t *)"replaced", 8) == SFCE_ERROR_OK);
+    TEST_EXPECT(sfce_piece_tree_compact_buffers(tree, &stats) == SFCE_ERROR_OK);
+    TEST_EXPECT(stats.freed_buffer_count == 0);
+
+    TEST_EXPECT(sfce_piece_tree_from_snapshot(tree, &snapshot) == SFCE_ERROR_OK);
+    TEST_EXPECT(test_tree_matches(tree, &document));
+
+    //
+    // Once the snapshot is gone its buffers are collected like any other.
+    //
+    struct sfce_piece_tree_stats snapshot_stats = {};
+    sfce_piece_tree_get_stats(tree, &snapshot_stats);
+    sfce_piece_tree_destroy_snapshot(tree, &snapshot);
+
+    TEST_EXPECT(sfce_piece_tree_erase_with_offset(tree, 0, tree->length) == SFCE_ERROR_OK);
+    TEST_EXPECT(sfce_piece_tree_collect_garbage(tree, NULL) == SFCE_ERROR_OK);
+    sfce_piece_tree_get_stats(tree, &stats);
+    TEST_EXPECT(stats.buffer_count < snapshot_stats.buffer_count);
+
+    document.size = 0;
+    TEST_EXPECT(test_tree_matches(tree, &document));
+
+    free(document.data);
+    sfce_piece_tree_destroy(tree);
+}
+
+static uint32_t test_random(uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 16;
+}
+
+//
+// Edits a tree of its own, large pastes included, while the other threads do the
+// same, so that every tree is rebalanced around the shared sentinel at once.
+//
+static void test_thread_edit_own_tree(struct test_thread *thread)
+{
+    static const char content[] = "abc \xC3\xA4\xC3\xB6\xC3\xBC\n";
+    struct sfce_piece_tree *tree = sfce_piece_tree_create();
+    uint8_t *paste = malloc(TEST_STRING_BUFFER_MULTIPLE * SFCE_STRING_BUFFER_SIZE_THRESHOLD);
+
+    if (tree == NULL || paste == NULL) {
+        thread->failed_check_count += 1;
+        free(paste);
+        sfce_piece_tree_destroy(tree);
+        return;
+    }
+
+    for (int32_t idx = 0; idx < TEST_STRING_BUFFER_MULTIPLE * SFCE_STRING_BUFFER_SIZE_THRESHOLD; ++idx) {
+        paste[idx] = 'a' + idx % 26;
+    }
+
+    for (int32_t step = 0; step < TEST_THREAD_STEP_COUNT; ++step) {
+        int32_t offset = tree->length != 0 ? test_random(&thread->seed) % tree->length : 0;
+        enum sfce_error_code error_code = SFCE_ERROR_OK;
+
+        uint32_t kind = test_random(&thread->seed) % 8;
+        if (kind == 0 && tree->length > TEST_PASTE_SIZE) {
+            kind = 4;
+        }
+
+        switch (kind) {
+        case 0:
+            error_code = sfce_piece_tree_insert_with_offset(tree, offset & ~0xF, paste, TEST_STRING_BUFFER_MULTIPLE * SFCE_STRING_BUFFER_SIZE_THRESHOLD);
+            break;
+        case 1: case 2: case 3:
+            error_code = sfce_piece_tree_insert_with_offset(tree, 0, (const uint8_t *)content, COUNTOF(content) - 1);
+            break;
+        default:
+            error_code = sfce_piece_tree_erase_with_offset(tree, offset, MIN(tree->length - offset, (int32_t)test_random(&thread->seed) % 4096));
+            break;
+        }
+
+        thread->failed_check_count += error_code != SFCE_ERROR_OK || test_black_height(tree->root) <= 0;
+    }
+
+    free(paste);
+    sfce_piece_tree_destroy(tree);
+}
+
+//
+// Reads the tree shared by every reader, which nobody edits, and checks random
+// lines of it against the document it was built from.
+//
+static void test_thread_read_shared_tree(struct test_thread *thread)
+{
+    struct sfce_piece_tree *tree = thread->shared_tree;
+    struct test_document *document = thread->shared_document;
+    struct sfce_string line = {};
+
+    for (int32_t step = 0; step < TEST_THREAD_STEP_COUNT; ++step) {
+        int32_t offset = test_random(&thread->seed) % document->size;
+        struct sfce_position position = sfce_piece_tree_position_at_offset(tree, offset);
+
+        if (sfce_piece_tree_get_line_content(tree, position.row, &line) != SFCE_ERROR_OK) {
+            thread->failed_check_count += 1;
+            continue;
+        }
+
+        int32_t line_offset = offset - position.col;
+        thread->failed_check_count += line.size > document->size - line_offset
+            || memcmp(line.data, &document->data[line_offset], line.size) != 0;
+
+        struct sfce_piece_tree_iterator iterator = sfce_piece_tree_iterator_at_offset(tree, offset);
+        int32_t codepoint;
+
+        for (int32_t idx = 0; idx < 64 && sfce_piece_tree_iterator_next(&iterator, &codepoint) != 0; ++idx) {
+            thread->failed_check_count += codepoint != document->data[offset + idx];
+        }
+    }
+
+    sfce_string_destroy(&line);
+}
+
+#if defined(SFCE_PLATFORM_WINDOWS)
+static DWORD WINAPI test_reader_thread_main(LPVOID parameter)
+#else
+static void *test_reader_thread_main(void *parameter)
+#endif
+{
+    struct test_thread *thread = parameter;
+
+    test_thread_read_shared_tree(thread);
+    test_thread_edit_own_tree(thread);
+    return 0;
+}
+
+#if defined(SFCE_PLATFORM_WINDOWS)
+static DWORD WINAPI test_editor_thread_main(LPVOID parameter)
+#else
+static void *test_editor_thread_main(void *parameter)
+#endif
+{
+    test_thread_edit_own_tree(parameter);
+    return 0;
+}
+
+//
+// Every tree shares the immutable sentinel, so trees used on different threads
+// must never race on it. Built with -fsanitize=thread by `make test-thread`.
+//
+static void test_threads_share_the_sentinel(void)
+{
+    struct sfce_piece_tree *tree = sfce_piece_tree_create();
+    struct test_document document = { .data = malloc(TEST_PASTE_SIZE) };
+    struct test_thread threads[TEST_READER_THREAD_COUNT + 1] = {};
+
+    TEST_EXPECT(tree != NULL && document.data != NULL);
+
+    for (int32_t idx = 0; idx < TEST_PASTE_SIZE; ++idx) {
+        document.data[idx] = idx % 73 == 72 ? '\n' : 'a' + idx % 26;
+    }
+
+    document.size = TEST_PASTE_SIZE;
+    TEST_EXPECT(sfce_piece_tree_insert_with_offset(tree, 0, document.data, document.size) == SFCE_ERROR_OK);
+
+    for (int32_t idx = 0; idx < COUNTOF(threads); ++idx) {
+        struct test_thread *thread = &threads[idx];
+        *thread = (struct test_thread) { .shared_tree = tree, .shared_document = &document, .seed = idx + 1 };
+
+#if defined(SFCE_PLATFORM_WINDOWS)
+        thread->handle = CreateThread(NULL, 0, idx == 0 ? test_editor_thread_main : test_reader_thread_main, thread, 0, NULL);
+        TEST_EXPECT(thread->handle != NULL);
+#else
+        TEST_EXPECT(pthread_create(&thread->handle, NULL, idx == 0 ? test_editor_thread_main : test_reader_thread_main, thread) == 0);
+#endif
+    }
+
+    for (int32_t idx = 0; idx < COUNTOF(threads); ++idx) {
+#if defined(SFCE_PLATFORM_WINDOWS)
+        WaitForSingleObject(threads[idx].handle, INFINITE);
+        CloseHandle(threads[idx].handle);
+#else
+        pthread_join(threads[idx].handle, NULL);
+#endif
+        TEST_EXPECT(threads[idx].failed_check_count == 0);
+    }
+
+    TEST_EXPECT(test_tree_matches(tree, &document));
+
+    free(document.data);
+    sfce_piece_tree_destroy(tree);
+}
+
+int main(void)
+{
+    test_paste_then_erase_at_random();
+    test_convert_case_larger_than_a_string_buffer();
+    test_convert_case_to_titlecase();
+    test_snapshot_survives_garbage_collection();
+    test_threads_share_the_sentinel();
+
+    if (g_failed_test_count != 0) {
+        fprintf(stderr, "%d tests failed\n", g_failed_test_count);
+        return 1;
+    }
+
+    fprintf(stderr, "All tests passed\n");
+    return 0;
+}